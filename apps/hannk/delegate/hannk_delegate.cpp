@@ -208,6 +208,8 @@ TensorPtr ConvertTfLiteTensor(const TfLiteTensor &tensor) {
     QuantizationInfo quantization;
     if (tensor.quantization.type == kTfLiteAffineQuantization) {
         const TfLiteAffineQuantization *q = (const TfLiteAffineQuantization *)tensor.quantization.params;
+        quantization.scale.reserve(q->scale->size);
+        quantization.zero.reserve(q->zero_point->size);
         for (int i = 0; i < q->scale->size; ++i) {
             const float scale = q->scale->data[i];
             quantization.scale.emplace_back(scale);
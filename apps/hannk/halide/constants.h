@@ -11,6 +11,8 @@ constexpr int add_output_shift = 16;
 
 constexpr int mul_input_shift = 6;
 
+constexpr int requantize_input_shift = 6;
+
 constexpr int softmax_input_shift = 6;
 
 }  // namespace hannk
@@ -107,6 +107,40 @@ public:
     }
 };
 
+// Changes the quantization of a uint8 tensor. This is equivalent to Add with
+// a zeroed second operand, but does one load and one multiply per element
+// instead of two of each.
+class Requantize : public Generator<Requantize> {
+public:
+    Input<Buffer<uint8_t, 2>> input_{"input"};
+    Input<uint8_t> input_zero_{"input_zero"};
+    Input<int16_t> multiplier_{"multiplier"};
+    Input<uint16_t> shift_{"shift"};
+
+    Input<uint8_t> output_zero_{"output_zero"};
+    Input<uint8_t> output_min_{"output_min"};
+    Input<uint8_t> output_max_{"output_max"};
+
+    Output<Buffer<uint8_t, 2>> output_{"output"};
+
+    void generate() {
+        Var x("x"), y("y");
+
+        Expr input = (i16(input_(x, y)) - i16(input_zero_)) << requantize_input_shift;
+
+        Expr output = multiply_2x_high(input, multiplier_);
+        output = rounding_shift_right(output, shift_);
+        output = u8_sat(saturating_add(output, output_zero_));
+        output_(x, y) = clamp(output, output_min_, output_max_);
+
+        // Schedule.
+        const int vector_size = natural_vector_size<uint8_t>();
+
+        output_.compute_root()
+            .vectorize(x, vector_size * 2, TailStrategy::Predicate);
+    }
+};
+
 // This is a generator that interprets programs to implement sequences of
 // elementwise operations dynamically.
 class Elementwise : public Generator<Elementwise> {
@@ -231,4 +265,5 @@ public:
 
 HALIDE_REGISTER_GENERATOR(hannk::Add, Add)
 HALIDE_REGISTER_GENERATOR(hannk::Mul, Mul)
+HALIDE_REGISTER_GENERATOR(hannk::Requantize, Requantize)
 HALIDE_REGISTER_GENERATOR(hannk::Elementwise, Elementwise)
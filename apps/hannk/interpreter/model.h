@@ -2,6 +2,7 @@
 #define HANNK_MODEL_H
 
 #include <array>
+#include <initializer_list>
 #include <iostream>
 #include <list>
 #include <map>
@@ -120,6 +121,15 @@ struct DimMap {
     }
 };
 
+// A single entry of a BoundsMap: the DimMap relating input dimension dim_in
+// to output dimension dim_out. A dim_out of -1 denotes the constant column,
+// which does not depend on any output dimension (see BoundsMap::at(dim_in)).
+struct DimSpec {
+    int dim_in;
+    int dim_out;
+    DimMap map;
+};
+
 class BoundsMap {
     int dims_in_;
     int dims_out_;
@@ -132,6 +142,16 @@ public:
         assert(dims_out <= max_rank);
     }
 
+    // Build the whole map in one pass, for map_bounds implementations with a
+    // fixed set of entries, instead of a chain of setter calls that each
+    // re-index data_.
+    BoundsMap(int dims_in, int dims_out, std::initializer_list<DimSpec> dims)
+        : BoundsMap(dims_in, dims_out) {
+        for (const DimSpec &d : dims) {
+            at(d.dim_in, d.dim_out < 0 ? dims_out_ : d.dim_out) = d.map;
+        }
+    }
+
     DimMap &at(int dim_in, int dim_out) {
         return data_[dim_in * (max_rank + 1) + dim_out];
     }
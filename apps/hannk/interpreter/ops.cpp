@@ -1,6 +1,11 @@
 #include <atomic>
 #include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #include "halide/add_uint8_uint8.h"
 #include "halide/average_pool_uint8.h"
@@ -10,6 +15,13 @@
 #ifdef CONV_R16
 #include "halide/conv_r16_u8_u8_i16.h"
 #include "halide/conv_r16_u8_u8_u8.h"
+#if defined(__linux__) && defined(__aarch64__)
+#include <sys/auxv.h>
+// Older libcs don't define this; the bit is part of the kernel ABI.
+#ifndef HWCAP_ASIMDDP
+#define HWCAP_ASIMDDP (1 << 20)
+#endif
+#endif
 #endif
 #include "halide/copy_uint8_uint8.h"
 #include "halide/depthwise_conv_broadcast_uint8.h"
@@ -22,6 +34,7 @@
 #include "halide/max_pool_uint8.h"
 #include "halide/mean_uint8.h"
 #include "halide/mul_uint8_uint8_uint8.h"
+#include "halide/requantize_uint8.h"
 #include "halide/softmax_uint8.h"
 #include "halide/tile_conv_filter_uint8.h"
 #include "halide/upsample_channels_uint8.h"
@@ -33,6 +46,10 @@ namespace hannk {
 
 namespace {
 
+// log2(e), for rewriting e^x as 2^(x*log2(e)). Spelled out as a literal
+// so it folds at compile time instead of calling into libm.
+constexpr float kLog2E = 1.4426950408889634f;
+
 #if 0
 // Useful for debugging
 std::string dims_to_string(const halide_buffer_t *buf) {
@@ -120,9 +137,11 @@ void fuse(int d0, int d1, FuseType type, halide_buffer_t *buf) {
     halide_dimension_t &dim1 = buf->dim[d1];
     dim0.extent *= dim1.extent;
     if (type == FuseType::Delete || type == FuseType::Pad) {
-        for (int d = d1; d + 1 < buf->dimensions; d++) {
-            buf->dim[d] = buf->dim[d + 1];
-        }
+        // Shift the dims after d1 down by one. This loop is short but hot
+        // (BinaryOp and ConvOp fuse repeatedly), so use one memmove instead
+        // of copying halide_dimension_t entries one at a time.
+        std::memmove(&buf->dim[d1], &buf->dim[d1 + 1],
+                     (buf->dimensions - d1 - 1) * sizeof(halide_dimension_t));
         if (type == FuseType::Pad) {
             halide_dimension_t &padded = buf->dim[buf->dimensions - 1];
             halide_dimension_t &prev = buf->dim[buf->dimensions - 2];
@@ -151,6 +170,46 @@ void fuse(int d0, int d1, FuseType type, halide_buffer_t *a, Bufs *...rest) {
     fuse(d0, d1, type, rest...);
 }
 
+// Count the dimensions following d that can be fused into d: the run of
+// dimensions whose strides chain densely onto d. This is equivalent to
+// repeatedly testing can_fuse(d, d + 1, ...) after each fuse, but with a
+// single scan of the raw dim array.
+int fusable_run(int d, const halide_buffer_t *buf) {
+    if (buf->dim[d].min != 0) {
+        return 0;
+    }
+    int run = 0;
+    while (d + run + 1 < buf->dimensions &&
+           buf->dim[d + run + 1].stride == buf->dim[d + run].extent * buf->dim[d + run].stride) {
+        run++;
+    }
+    return run;
+}
+
+// Fuse the `count` dimensions following d into d, preserving the rank by
+// appending extent-1 dims at the end (as FuseType::Pad does), with one
+// memmove of the tail instead of one per fused dimension.
+void fuse_run(int d, int count, halide_buffer_t *buf) {
+    for (int i = d + 1; i <= d + count; i++) {
+        buf->dim[d].extent *= buf->dim[i].extent;
+    }
+    std::memmove(&buf->dim[d + 1], &buf->dim[d + count + 1],
+                 (buf->dimensions - d - count - 1) * sizeof(halide_dimension_t));
+    for (int i = buf->dimensions - count; i < buf->dimensions; i++) {
+        halide_dimension_t &padded = buf->dim[i];
+        halide_dimension_t &prev = buf->dim[i - 1];
+        padded.min = 0;
+        padded.extent = 1;
+        padded.stride = prev.extent * prev.stride;
+    }
+}
+
+template<typename... Bufs>
+void fuse_run(int d, int count, halide_buffer_t *a, Bufs *...rest) {
+    fuse_run(d, count, a);
+    fuse_run(d, count, rest...);
+}
+
 // Embed extent 1 dimensions until buf has the given rank.
 template<typename T>
 void pad_to_rank(int rank, HalideBuffer<T> &buf) {
@@ -174,21 +233,6 @@ bool all(bool first, T... rest) {
     return first && all(rest...);
 }
 
-// Fuse the innermost (stride 1) dimension with other dimensions as much as possible.
-// This may enable the buffers to be processed with fewer instances of the "tail" of
-// a vectorization loop, and fewer levels of recursion in the loop nest helpers below.
-template<typename... Bufs>
-void optimize_elementwise_shapes(halide_buffer_t *a, Bufs *...rest) {
-    assert(all(a->dimensions == rest->dimensions...));
-    for (int d = 0; d + 1 < a->dimensions; d++) {
-        while (can_fuse(d, d + 1, FuseType::Pad, a) &&
-               all(can_fuse(d, d + 1, FuseType::Pad, rest)...) &&
-               all(a->dim[d].extent == rest->dim[d].extent...)) {
-            fuse(d, d + 1, FuseType::Pad, a, rest...);
-        }
-    }
-}
-
 // A hack to allow us to pass a type for each halide_buffer_t object.
 template<typename T>
 class TypedBufferT : public halide_buffer_t {};
@@ -258,15 +302,76 @@ int max(const halide_dimension_t &d) {
     return d.min + d.extent - 1;
 }
 
-// Broadcast the extent 1 dimensions of one shape to match the extent of the
-// other shape.
+// Broadcast the extent 1 dimensions of each shape to match the extent of the
+// other shapes, then fuse the dimensions where the strides of all buffers
+// chain densely, in one pass over the dims. Fusing fewer, bigger dimensions
+// lets the buffers be processed with fewer instances of the "tail" of a
+// vectorization loop, and fewer levels of recursion in the loop nest helpers
+// below. Fusing after broadcasting means a broadcast (stride 0) dimension
+// only fuses with an adjacent broadcast dimension, while the dense prefix of
+// the common bias-add / residual-add case collapses to a single
+// 1D-vectorizable loop.
 template<typename... Bufs>
-void broadcast_shapes(int rank, halide_buffer_t *a, Bufs *...rest) {
+void broadcast_and_fuse_shapes(int rank, halide_buffer_t *a, Bufs *...rest) {
+    assert(all(rank == a->dimensions, rank == rest->dimensions...));
     for (int d = 0; d < rank; d++) {
         int min = std::min({a->dim[d].min, rest->dim[d].min...});
         int extent = std::max({max(a->dim[d]), max(rest->dim[d])...}) - min + 1;
         broadcast_dims(min, extent, &a->dim[d], &rest->dim[d]...);
     }
+    // After broadcasting, every buffer has the same extents, so fusability
+    // only depends on the strides.
+    for (int d = 0; d + 1 < rank; d++) {
+        int run = std::min({fusable_run(d, a), fusable_run(d, rest)...});
+        if (run > 0) {
+            fuse_run(d, run, a, rest...);
+        }
+    }
+}
+
+// Check if the buffer's elements are stored densely in memory: the innermost
+// dimension has stride 1, and each subsequent dimension's stride is the
+// product of the extents below it.
+bool is_contiguous(const halide_buffer_t *buf) {
+    int stride = 1;
+    for (int d = 0; d < buf->dimensions; d++) {
+        if (buf->dim[d].stride != stride) {
+            return false;
+        }
+        stride *= buf->dim[d].extent;
+    }
+    return true;
+}
+
+// If every buffer has identical dims and the elements are dense in memory,
+// rewrite them in place as flat rank-FnRank views with everything fused into
+// dimension 0, and return true. This is the common no-broadcast,
+// matching-shape case (e.g. residual adds): one dim-array memcmp per operand
+// replaces the broadcast and fuse scans.
+template<int FnRank, typename... Bufs>
+bool flatten_if_dense(halide_buffer_t *a, Bufs *...rest) {
+    if (!is_contiguous(a)) {
+        return false;
+    }
+    const size_t dims_bytes = a->dimensions * sizeof(halide_dimension_t);
+    if (!all((std::memcmp(a->dim, rest->dim, dims_bytes) == 0)...)) {
+        return false;
+    }
+    int64_t elements = 1;
+    for (int d = 0; d < a->dimensions; d++) {
+        elements *= a->dim[d].extent;
+    }
+    if (elements > std::numeric_limits<int32_t>::max()) {
+        return false;
+    }
+    for (halide_buffer_t *buf : {a, rest...}) {
+        buf->dimensions = FnRank;
+        buf->dim[0] = halide_dimension_t(0, (int32_t)elements, 1);
+        for (int d = 1; d < FnRank; d++) {
+            buf->dim[d] = halide_dimension_t(0, 1, (int32_t)elements);
+        }
+    }
+    return true;
 }
 
 // This helper implements all of the logic necessary for elementwise operations:
@@ -278,8 +383,9 @@ template<int FnRank, typename Fn, typename T, typename... Ts>
 void elementwise_loop_nest(Fn &&fn, HalideBuffer<T> op0, HalideBuffer<Ts>... ops) {
     const int rank = std::max({FnRank, op0.dimensions(), ops.dimensions()...});
     pad_to_rank(rank, op0, ops...);
-    broadcast_shapes(rank, op0.raw_buffer(), ops.raw_buffer()...);
-    optimize_elementwise_shapes(op0.raw_buffer(), ops.raw_buffer()...);
+    if (!flatten_if_dense<FnRank>(op0.raw_buffer(), ops.raw_buffer()...)) {
+        broadcast_and_fuse_shapes(rank, op0.raw_buffer(), ops.raw_buffer()...);
+    }
     loop_nest_impl<FnRank>(fn, *op0.raw_buffer(), *ops.raw_buffer()...);
 }
 
@@ -289,8 +395,7 @@ template<typename Fn, typename T, typename... Ts>
 void scalar_elementwise_loop_nest(Fn &&fn, HalideBuffer<T> op0, HalideBuffer<Ts>... ops) {
     const int rank = std::max({op0.dimensions(), ops.dimensions()...});
     pad_to_rank(rank, op0, ops...);
-    broadcast_shapes(rank, op0.raw_buffer(), ops.raw_buffer()...);
-    optimize_elementwise_shapes(op0.raw_buffer(), ops.raw_buffer()...);
+    broadcast_and_fuse_shapes(rank, op0.raw_buffer(), ops.raw_buffer()...);
     scalar_loop_nest_impl(fn, *(TypedBufferT<T> *)op0.raw_buffer(), *(TypedBufferT<Ts> *)ops.raw_buffer()...);
 }
 
@@ -302,124 +407,83 @@ void loop_nest(Fn &&fn, HalideBuffer<T> op0, HalideBuffer<Ts>... ops) {
 }
 
 // Check if and b are aliases of the same buffer.
+// Compute each byte range exactly once (begin()/end() walk the dims), and
+// combine the two overlap tests with & rather than && so this compiles to
+// two compares and an and, with no branches.
 bool is_alias(const halide_buffer_t *a, const halide_buffer_t *b) {
-    return std::max(a->begin(), b->begin()) < std::min(a->end(), b->end());
+    const uintptr_t a_begin = (uintptr_t)a->begin();
+    const uintptr_t a_end = (uintptr_t)a->end();
+    const uintptr_t b_begin = (uintptr_t)b->begin();
+    const uintptr_t b_end = (uintptr_t)b->end();
+    return (a_begin < b_end) & (b_begin < a_end);
+}
+
+// Crop both a and b to the union of both buffers, in a single pass over the
+// raw dims instead of a Buffer::crop call per buffer per dimension.
+void crop_to_union(halide_buffer_t *a, halide_buffer_t *b) {
+    assert(a->dimensions == b->dimensions);
+    const int a_bytes = a->type.bytes();
+    const int b_bytes = b->type.bytes();
+    for (int d = 0; d < a->dimensions; d++) {
+        halide_dimension_t &da = a->dim[d];
+        halide_dimension_t &db = b->dim[d];
+        const int min = std::max(da.min, db.min);
+        const int max = std::min(da.min + da.extent, db.min + db.extent) - 1;
+        if (a->host) {
+            a->host += (int64_t)(min - da.min) * da.stride * a_bytes;
+        }
+        if (b->host) {
+            b->host += (int64_t)(min - db.min) * db.stride * b_bytes;
+        }
+        da.min = min;
+        db.min = min;
+        da.extent = max - min + 1;
+        db.extent = max - min + 1;
+    }
 }
 
-// Crop both a and b to the union of both buffers.
 template<typename T, typename U>
 void crop_to_union(HalideBuffer<T> &a, HalideBuffer<U> &b) {
-    assert(a.dimensions() == b.dimensions());
-    for (int d = 0; d < a.dimensions(); d++) {
-        int min = std::max(a.dim(d).min(), b.dim(d).min());
-        int max = std::min(a.dim(d).max(), b.dim(d).max());
-        a.crop(d, min, max - min + 1);
-        b.crop(d, min, max - min + 1);
-    }
+    crop_to_union(a.raw_buffer(), b.raw_buffer());
 }
 
-// A type safe power of two.
-struct power_of_two {
-    int value;
-
-    explicit power_of_two(int value)
-        : value(value) {
-    }
-};
-
-// Represents a number as mantissa*2^exponent/2^(bits - 1), where bits = 8*sizeof(T)
-// This is very similar to a float.
-template<typename T>
-class IntFloat {
-    T mantissa_;
-    T exponent_;
-
-    static constexpr int log2_one = sizeof(T) * 8 - 1;
-    static constexpr int64_t one = 1LL << log2_one;
-
-public:
-    IntFloat()
-        : mantissa_(0), exponent_(0) {
-    }
-
-    IntFloat(float x) {
-        int exponent;
-        float mantissa_float = std::frexp(x, &exponent);
-        int64_t mantissa_long = (int64_t)std::round(mantissa_float * one);
-        assert(std::abs(mantissa_long) <= one);
-        if (mantissa_long == one) {
-            mantissa_long >>= 1;
-            ++exponent;
-        }
-        mantissa_ = mantissa_long;
-        exponent_ = exponent;
-    }
-
-    // Multiply this value by a constant power of 2.
-    IntFloat operator*=(power_of_two x) {
-        exponent_ += x.value;
-        return *this;
-    }
-
-    T mantissa() const {
-        if (exponent_ < -log2_one) {
-            return 0;
-        } else {
-            return mantissa_;
-        }
-    }
-
-    T exponent() const {
-        if (exponent_ < -log2_one) {
-            return -log2_one;
-        } else if (exponent_ > log2_one) {
-            return log2_one;
-        } else {
-            return exponent_;
-        }
-    }
-};
-
 Interval get_quantized_min_max(ActivationFunction activation, int zero_point, double scale) {
-    int min = 0;
-    int max = 255;
-    if (activation == ActivationFunction::None) {
-        // nothing
-    } else if (activation == ActivationFunction::Relu) {
-        min = zero_point;
-    } else if (activation == ActivationFunction::Relu6) {
-        min = zero_point;
-        max = zero_point + (int)std::round(6.0 / scale);
-    } else if (activation == ActivationFunction::ReluN1To1) {
-        min = zero_point + (int)std::round(-1.0 / scale);
-        max = zero_point + (int)std::round(1.0 / scale);
-    } else {
+    // The real-valued range each activation function clamps to, in the same
+    // order as the ActivationFunction enum. The infinities saturate against
+    // the uint8 range below.
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    struct Range {
+        double lo, hi;
+    };
+    static constexpr Range ranges[] = {
+        {-inf, inf},  // None
+        {0.0, inf},   // Relu
+        {-1.0, 1.0},  // ReluN1To1
+        {0.0, 6.0},   // Relu6
+    };
+    const int i = (int)activation;
+    if (i < 0 || i >= (int)(sizeof(ranges) / sizeof(ranges[0]))) {
         HLOG(FATAL) << "Unsupported quantized activation function type.";
     }
-    return {std::max(min, 0), std::min(max, 255)};
+    const double min = zero_point + std::round(ranges[i].lo / scale);
+    const double max = zero_point + std::round(ranges[i].hi / scale);
+    return {(int)std::max(min, 0.0), (int)std::min(max, 255.0)};
 }
 
 Interval get_output_range(ActivationFunction activation, const QuantizationInfo &quantization) {
     const int output_zero = quantization.uniform_zero();
-    assert(output_zero >= 0 && output_zero <= 255);
+    HANNK_ASSUME(output_zero >= 0 && output_zero <= 255);
 
     const float output_scale = quantization.uniform_scale();
 
     const auto output_range = get_quantized_min_max(activation, output_zero, output_scale);
-    assert(output_range.min >= 0 && output_range.min <= 255);
-    assert(output_range.max >= 0 && output_range.max <= 255);
-    assert(output_range.min <= output_range.max);
+    HANNK_ASSUME(output_range.min >= 0 && output_range.min <= 255);
+    HANNK_ASSUME(output_range.max >= 0 && output_range.max <= 255);
+    HANNK_ASSUME(output_range.min <= output_range.max);
 
     return output_range;
 }
 
-struct MultiplyParams {
-    int a_zero;
-    int b_zero;
-    int c_zero;
-    IntFloat<int32_t> c;
-};
-
 MultiplyParams get_quantized_multiply_params(const QuantizationInfo &a, const QuantizationInfo &b, const QuantizationInfo &c) {
     MultiplyParams result;
     result.a_zero = a.uniform_zero();
@@ -434,37 +498,49 @@ MultiplyParams get_quantized_multiply_params(const QuantizationInfo &a, const Qu
     return result;
 }
 
-void add_uint8(const HalideBuffer<const void> &in1, const QuantizationInfo &in1q, int in1sign,
-               const HalideBuffer<const void> &in2, const QuantizationInfo &in2q, int in2sign,
-               const HalideBuffer<void> &out, const QuantizationInfo &outq,
-               ActivationFunction activation = ActivationFunction::None) {
-    const int in1_zero = in1q.uniform_zero();
-    const int in2_zero = in2q.uniform_zero();
-    const int out_zero = outq.uniform_zero();
+BinaryOp::AddParams get_add_params(const QuantizationInfo &in1q, int in1sign,
+                                   const QuantizationInfo &in2q, int in2sign,
+                                   const QuantizationInfo &outq,
+                                   ActivationFunction activation) {
+    BinaryOp::AddParams params;
+    params.in1_zero = in1q.uniform_zero();
+    params.in2_zero = in2q.uniform_zero();
+    params.out_zero = outq.uniform_zero();
 
     const float in1_scale = in1q.uniform_scale() * (1 << add_output_shift);
     const float in2_scale = in2q.uniform_scale() * (1 << add_output_shift);
     const float out_scale = outq.uniform_scale() * (1 << add_input_shift);
 
-    const int in1_multiplier = std::lround(in1_scale / out_scale) * in1sign;
-    const int in2_multiplier = std::lround(in2_scale / out_scale) * in2sign;
+    params.in1_multiplier = std::lround(in1_scale / out_scale) * in1sign;
+    params.in2_multiplier = std::lround(in2_scale / out_scale) * in2sign;
 
-    const auto out_range = get_output_range(activation, outq);
+    params.out_range = get_output_range(activation, outq);
+    return params;
+}
 
+void add_uint8(const HalideBuffer<const void> &in1, const HalideBuffer<const void> &in2,
+               const HalideBuffer<void> &out, const BinaryOp::AddParams &params) {
     auto add_rank2 = [&](halide_buffer_t *in1_buf, halide_buffer_t *in2_buf, halide_buffer_t *out_buf) {
-        add_uint8_uint8(in1_buf, in1_zero, in1_multiplier, in2_buf, in2_zero, in2_multiplier,
-                        out_zero, out_range.min, out_range.max, out_buf);
+        add_uint8_uint8(in1_buf, params.in1_zero, params.in1_multiplier,
+                        in2_buf, params.in2_zero, params.in2_multiplier,
+                        params.out_zero, params.out_range.min, params.out_range.max, out_buf);
     };
     elementwise_loop_nest<2>(add_rank2, in1, in2, out);
 }
 
-void mul_uint8(const HalideBuffer<const void> &in1, const QuantizationInfo &in1q,
-               const HalideBuffer<const void> &in2, const QuantizationInfo &in2q,
+void add_uint8(const HalideBuffer<const void> &in1, const QuantizationInfo &in1q, int in1sign,
+               const HalideBuffer<const void> &in2, const QuantizationInfo &in2q, int in2sign,
                const HalideBuffer<void> &out, const QuantizationInfo &outq,
                ActivationFunction activation = ActivationFunction::None) {
-    const int in1_zero = in1q.uniform_zero();
-    const int in2_zero = in2q.uniform_zero();
-    const int out_zero = outq.uniform_zero();
+    add_uint8(in1, in2, out, get_add_params(in1q, in1sign, in2q, in2sign, outq, activation));
+}
+
+BinaryOp::MulParams get_mul_params(const QuantizationInfo &in1q, const QuantizationInfo &in2q,
+                                   const QuantizationInfo &outq, ActivationFunction activation) {
+    BinaryOp::MulParams params;
+    params.in1_zero = in1q.uniform_zero();
+    params.in2_zero = in2q.uniform_zero();
+    params.out_zero = outq.uniform_zero();
 
     const float in1_scale = in1q.uniform_scale();
     const float in2_scale = in2q.uniform_scale();
@@ -473,17 +549,30 @@ void mul_uint8(const HalideBuffer<const void> &in1, const QuantizationInfo &in1q
     IntFloat<int32_t> multiplier(in1_scale * in2_scale / out_scale);
     multiplier *= power_of_two(-2 * mul_input_shift);
     assert(multiplier.exponent() <= 0);
+    params.multiplier = multiplier.mantissa();
+    params.shift = -multiplier.exponent();
 
-    const auto out_range = get_output_range(activation, outq);
+    params.out_range = get_output_range(activation, outq);
+    return params;
+}
 
+void mul_uint8(const HalideBuffer<const void> &in1, const HalideBuffer<const void> &in2,
+               const HalideBuffer<void> &out, const BinaryOp::MulParams &params) {
     auto mul_rank2 = [&](halide_buffer_t *in1_buf, halide_buffer_t *in2_buf, halide_buffer_t *out_buf) {
-        mul_uint8_uint8_uint8(in1_buf, in1_zero, in2_buf, in2_zero,
-                              out_zero, multiplier.mantissa(), -multiplier.exponent(),
-                              out_range.min, out_range.max, out_buf);
+        mul_uint8_uint8_uint8(in1_buf, params.in1_zero, in2_buf, params.in2_zero,
+                              params.out_zero, params.multiplier, params.shift,
+                              params.out_range.min, params.out_range.max, out_buf);
     };
     elementwise_loop_nest<2>(mul_rank2, in1, in2, out);
 }
 
+void mul_uint8(const HalideBuffer<const void> &in1, const QuantizationInfo &in1q,
+               const HalideBuffer<const void> &in2, const QuantizationInfo &in2q,
+               const HalideBuffer<void> &out, const QuantizationInfo &outq,
+               ActivationFunction activation = ActivationFunction::None) {
+    mul_uint8(in1, in2, out, get_mul_params(in1q, in2q, outq, activation));
+}
+
 bool try_requantize(const HalideBuffer<const void> &in, const QuantizationInfo &inq,
                     HalideBuffer<void> out, const QuantizationInfo &outq,
                     ActivationFunction activation = ActivationFunction::None) {
@@ -494,9 +583,31 @@ bool try_requantize(const HalideBuffer<const void> &in, const QuantizationInfo &
 
     if (in.type() == halide_type_of<uint8_t>() &&
         out.type() == halide_type_of<uint8_t>()) {
-        // TODO: Maybe a dedicated pipeline for this would be better. It
-        // could be a little faster, and avoid some quantization error.
-        add_uint8(in, inq, 1, in, inq, 0, out, outq, activation);
+        const int in_zero = inq.uniform_zero();
+        const int out_zero = outq.uniform_zero();
+        const float in_scale = inq.uniform_scale();
+        const float out_scale = outq.uniform_scale();
+
+        if (activation == ActivationFunction::None &&
+            in_zero == out_zero && in_scale == out_scale) {
+            // The quantization matches, so this is just a copy.
+            if (!is_alias(in.raw_buffer(), out.raw_buffer())) {
+                out.copy_from(in);
+            }
+            return true;
+        }
+
+        IntFloat<int16_t> multiplier(in_scale / out_scale);
+        multiplier *= power_of_two(-requantize_input_shift);
+        assert(multiplier.exponent() <= 0);
+
+        const auto out_range = get_output_range(activation, outq);
+
+        auto requantize_rank2 = [&](halide_buffer_t *in_buf, halide_buffer_t *out_buf) {
+            requantize_uint8(in_buf, in_zero, multiplier.mantissa(), -multiplier.exponent(),
+                             out_zero, out_range.min, out_range.max, out_buf);
+        };
+        elementwise_loop_nest<2>(requantize_rank2, in, out);
         return true;
     }
 
@@ -651,6 +762,36 @@ bool try_scalar_binary_op(BinaryOp::Operator op, const TensorPtr &a, const Tenso
 
 }  // namespace
 
+bool BinaryOp::prepare() {
+    const TensorPtr &in1 = input(0);
+    const TensorPtr &in2 = input(1);
+    const TensorPtr &out = output();
+
+    // The quantization of the tensors won't change after this, so we can
+    // precompute the parameters for the uint8 paths here and avoid the
+    // floating point math on every execute().
+    if (in1->type() == halide_type_of<uint8_t>() &&
+        in2->type() == halide_type_of<uint8_t>() &&
+        out->type() == halide_type_of<uint8_t>()) {
+        switch (op_) {
+        case Add:
+        case Sub:
+            add_params_ = get_add_params(in1->quantization(), 1, in2->quantization(),
+                                         op_ == Add ? 1 : -1, out->quantization(), activation_);
+            has_uint8_params_ = true;
+            break;
+        case Mul:
+            mul_params_ = get_mul_params(in1->quantization(), in2->quantization(),
+                                         out->quantization(), activation_);
+            has_uint8_params_ = true;
+            break;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
 void BinaryOp::execute() {
     const TensorPtr &in1 = input(0);
     const TensorPtr &in2 = input(1);
@@ -666,10 +807,12 @@ void BinaryOp::execute() {
         switch (op_) {
         case Add:
         case Sub:
-            add_uint8(in1_buf, in1->quantization(), 1, in2_buf, in2->quantization(), op_ == Add ? 1 : -1, out_buf, out->quantization(), activation_);
+            assert(has_uint8_params_);
+            add_uint8(in1_buf, in2_buf, out_buf, add_params_);
             return;
         case Mul:
-            mul_uint8(in1_buf, in1->quantization(), in2_buf, in2->quantization(), out_buf, out->quantization(), activation_);
+            assert(has_uint8_params_);
+            mul_uint8(in1_buf, in2_buf, out_buf, mul_params_);
             return;
         default:
             break;
@@ -724,12 +867,20 @@ BoundsMap ConcatenationOp::map_bounds(int input_idx, int output_idx) const {
     int rank = output()->rank();
     assert(rank == input(input_idx)->rank());
 
-    int offset = 0;
-    for (int i = 0; i < input_idx; i++) {
-        offset += input(i)->extent(axis_);
+    // map_bounds gets called for every input, so summing the preceding
+    // extents here would be quadratic in the number of inputs (some concats
+    // have dozens). Compute the partial sums once; the input shapes don't
+    // change after bounds inference starts.
+    if (input_axis_offsets_.empty()) {
+        input_axis_offsets_.reserve(input_count());
+        int offset = 0;
+        for (int i = 0; i < input_count(); i++) {
+            input_axis_offsets_.push_back(offset);
+            offset += input(i)->extent(axis_);
+        }
     }
     BoundsMap result = BoundsMap::elementwise(rank);
-    result.at(axis_, axis_).bounds += offset;
+    result.at(axis_, axis_).bounds += input_axis_offsets_[input_idx];
     return result;
 }
 
@@ -738,6 +889,10 @@ void ConcatenationOp::execute() {
         return;
     }
     const auto &output_buf = output()->buffer();
+    const QuantizationInfo &outq = output()->quantization();
+    // Hoist the output's quantization key out of the loop; comparing
+    // fingerprints avoids walking the scale/zero vectors once per input.
+    const uint64_t out_fingerprint = outq.uniform_fingerprint();
 
     int concatenated_i = 0;
     for (int i = 0; i < input_count(); i++) {
@@ -749,24 +904,48 @@ void ConcatenationOp::execute() {
         auto output_crop = output_buf;
         crop_to_union(output_crop, input_buf);
 
-        bool copied = requantize_or_copy(input_buf, input(i)->quantization(), output_crop, output()->quantization());
+        // When the quantization matches and both the input and the cropped
+        // output are dense, this is a plain contiguous copy. Bypassing the
+        // pipeline launch matters for concatenations of many small inputs,
+        // where the launch overhead dominates the bytes moved.
+        if (input_buf.type() == output_crop.type() &&
+            out_fingerprint != QuantizationInfo::kInvalidFingerprint &&
+            input(i)->quantization().uniform_fingerprint() == out_fingerprint &&
+            is_contiguous(input_buf) && is_contiguous(output_crop)) {
+            // In a partially-aliased concat, this input may already be an
+            // alias of its slice of the output; memcpy with identical
+            // src/dst is UB, and there is nothing to copy anyway.
+            if (output_crop.begin() != input_buf.begin()) {
+                memcpy(output_crop.begin(), input_buf.begin(), input_buf.size_in_bytes());
+            }
+            continue;
+        }
+
+        // When the quantization differs, this runs the fused requantize_uint8
+        // pipeline directly on the output crop: one load, one multiply and
+        // one store per element, with no intermediate buffer.
+        bool copied = requantize_or_copy(input_buf, input(i)->quantization(), output_crop, outq);
         HCHECK(copied);
     }
 }
 
 halide_type_t ConvOp::filter_type() const {
-    if (input()->type() == halide_type_of<uint8_t>() &&
-        output()->type() == halide_type_of<uint8_t>()) {
-        const halide_filter_metadata_t *metadata = conv_u8_u8_u8_metadata();
-        return metadata->arguments[2].type;
-    } else if (input()->type() == halide_type_of<uint8_t>() &&
-               output()->type() == halide_type_of<int16_t>()) {
-        const halide_filter_metadata_t *metadata = conv_u8_u8_i16_metadata();
-        return metadata->arguments[2].type;
-    } else {
-        HLOG(FATAL) << "Unsupported type " << output()->type() << "\n";
-        return halide_type_t(halide_type_int, 0, 0);
+    // This gets asked for repeatedly during lowering and bounds inference;
+    // look up the metadata once and cache the answer.
+    if (filter_type_.bits == 0) {
+        if (input()->type() == halide_type_of<uint8_t>() &&
+            output()->type() == halide_type_of<uint8_t>()) {
+            const halide_filter_metadata_t *metadata = conv_u8_u8_u8_metadata();
+            filter_type_ = metadata->arguments[2].type;
+        } else if (input()->type() == halide_type_of<uint8_t>() &&
+                   output()->type() == halide_type_of<int16_t>()) {
+            const halide_filter_metadata_t *metadata = conv_u8_u8_i16_metadata();
+            filter_type_ = metadata->arguments[2].type;
+        } else {
+            HLOG(FATAL) << "Unsupported type " << output()->type() << "\n";
+        }
     }
+    return filter_type_;
 }
 
 BoundsMap ConvOp::map_bounds(int input_idx, int output_idx) const {
@@ -801,12 +980,29 @@ BoundsMap ConvOp::map_bounds(int input_idx, int output_idx) const {
         return result;
     } else {
         assert(input_idx == 2);
-        return BoundsMap(1, output()->rank()).elementwise(0, 0);
+        return BoundsMap(1, output()->rank(), {{0, 0, DimMap().elementwise()}});
     }
 }
 
 namespace {
 
+#ifdef CONV_R16
+bool can_use_conv_r16() {
+#if defined(__linux__) && defined(__aarch64__)
+    // The r16 kernels are compiled with the dotprod extension, which is an
+    // illegal instruction on cores that don't have it. Ask the kernel once
+    // whether this CPU supports it.
+    static const bool supported = (getauxval(AT_HWCAP) & HWCAP_ASIMDDP) != 0;
+    return supported;
+#else
+    // On other platforms there is no runtime CPU check; the build only
+    // includes the r16 kernels when the user put arm_dot_prod in the target,
+    // which already implies they can run.
+    return true;
+#endif
+}
+#endif
+
 void call_conv2d(halide_buffer_t *input, halide_buffer_t *filter, halide_buffer_t *bias,
                  const MultiplyParams &params, const std::array<int, 2> &stride,
                  const std::array<int, 2> &dilation, const Interval &output_range,
@@ -815,7 +1011,7 @@ void call_conv2d(halide_buffer_t *input, halide_buffer_t *filter, halide_buffer_
 
     Conv2DFn fn;
 #ifdef CONV_R16
-    if (input->dim[0].extent >= 16) {
+    if (can_use_conv_r16() && input->dim[0].extent >= 16) {
         // For large reductions, use the big reduction version.
         // TODO: We really ought to be able to do this with GuardWithIf
         // and/or specialize.
@@ -846,6 +1042,17 @@ bool ConvOp::prepare() {
 
     vector_reduction_ = filter_buf.dim(0).extent();
     vector_tile_ = filter_buf.dim(1).extent();
+
+    // The quantization of the tensors doesn't change between executions, so
+    // the frexp/round work to derive the fixed point multiplier can be done
+    // once here. Only for quantized tensors, though: float tensors have no
+    // quantization to read, and execute() reports them as unsupported.
+    if (input()->type() == halide_type_of<uint8_t>() &&
+        filter()->type() == halide_type_of<uint8_t>()) {
+        multiply_params_ =
+            get_quantized_multiply_params(input()->quantization(), filter()->quantization(), output()->quantization());
+        output_range_ = get_output_range(activation_, output()->quantization());
+    }
     return true;
 }
 
@@ -861,11 +1068,6 @@ void ConvOp::execute() {
         auto bias_buf = bias()->buffer();
         auto output_buf = out->buffer();
 
-        MultiplyParams params =
-            get_quantized_multiply_params(in->quantization(), filt->quantization(), out->quantization());
-
-        const auto output_range = get_output_range(activation_, out->quantization());
-
         // Pad with dummy dimensions up to 2D.
         while (input_buf.dimensions() < 4) {
             input_buf.embed(input_buf.dimensions() - 1, 1);
@@ -878,14 +1080,22 @@ void ConvOp::execute() {
         const int filter_height = filter_buf.dim(5).extent();
         if (filter_width == 1 && filter_height == 1) {
             // For 1x1 filters, we can fuse x and y, which can help avoid overhead for
-            // small output sizes.
+            // small output sizes. Collapse the whole fusable run of dimensions in
+            // one step rather than re-checking can_fuse_xy after each fuse.
             // TODO: Maybe we can just treat all of x, y, b as batch dimensions and fuse
             // them all where possible, which might be a further improvement.
-            while (can_fuse_xy(FuseType::Pad, input_buf) &&
-                   can_fuse_xy(FuseType::Pad, output_buf) &&
-                   input_buf.dim(1).extent() == output_buf.dim(1).extent()) {
-                fuse_xy(FuseType::Pad, input_buf);
-                fuse_xy(FuseType::Pad, output_buf);
+            const int run = std::min(fusable_run(1, input_buf.raw_buffer()),
+                                     fusable_run(1, output_buf.raw_buffer()));
+            int count = 0;
+            int64_t in_extent = input_buf.dim(1).extent();
+            int64_t out_extent = output_buf.dim(1).extent();
+            for (int i = 1; i <= run && in_extent == out_extent; i++) {
+                count = i;
+                in_extent *= input_buf.dim(1 + i).extent();
+                out_extent *= output_buf.dim(1 + i).extent();
+            }
+            if (count > 0) {
+                fuse_run(1, count, input_buf.raw_buffer(), output_buf.raw_buffer());
             }
 
             if (output_buf.dim(1).extent() < output_buf.dim(2).extent()) {
@@ -897,7 +1107,7 @@ void ConvOp::execute() {
             }
         }
 
-        call_conv2d(input_buf, filter_buf, bias_buf, params, stride_, dilation_, output_range, output_buf);
+        call_conv2d(input_buf, filter_buf, bias_buf, multiply_params_, stride_, dilation_, output_range_, output_buf);
     } else {
         HLOG(FATAL) << "Unsupported type " << out->type() << "\n";
     }
@@ -961,12 +1171,13 @@ BoundsMap DepthwiseConv2DOp::map_bounds(int input_idx, int output_idx) const {
         }
         return result;
     } else if (input_idx == 1) {
-        return BoundsMap(3, 4)
-            .elementwise(0, 0)
-            .constant(1, filter()->bounds(1))
-            .constant(2, filter()->bounds(2));
+        return BoundsMap(3, 4, {
+                                   {0, 0, DimMap().elementwise()},
+                                   {1, -1, DimMap().constant(filter()->bounds(1))},
+                                   {2, -1, DimMap().constant(filter()->bounds(2))},
+                               });
     } else if (input_idx == 2) {
-        return BoundsMap(1, 4).elementwise(0, 0);
+        return BoundsMap(1, 4, {{0, 0, DimMap().elementwise()}});
     } else {
         return BoundsMap(0, 4);
     }
@@ -983,6 +1194,18 @@ bool DepthwiseConv2DOp::prepare() {
         return false;
     }
     channel_alignment_ = input_buf.dim(0).extent();
+
+    // The quantization of the tensors doesn't change between executions;
+    // derive the fixed point multiplier and output range once here. Only for
+    // quantized tensors, though: float tensors have no quantization to read,
+    // and execute() reports them as unsupported.
+    if (input()->type() == halide_type_of<uint8_t>() &&
+        filter()->type() == halide_type_of<uint8_t>() &&
+        output()->type() == halide_type_of<uint8_t>()) {
+        multiply_params_ =
+            get_quantized_multiply_params(input()->quantization(), filter()->quantization(), output()->quantization());
+        output_range_ = get_output_range(activation_, output()->quantization());
+    }
     return true;
 }
 
@@ -999,11 +1222,6 @@ void DepthwiseConv2DOp::execute() {
         auto bias_buf = bias()->buffer();
         auto output_buf = out->buffer();
 
-        MultiplyParams params =
-            get_quantized_multiply_params(in->quantization(), filt->quantization(), out->quantization());
-
-        const auto output_range = get_output_range(activation_, out->quantization());
-
         // If the number of channels is small and divides the channel alignment,
         // and the stride of the filter in x is 1, we can use the "shallow"
         // version of depthwise conv, which fuses c and x, and passes the stride
@@ -1019,8 +1237,8 @@ void DepthwiseConv2DOp::execute() {
         }
 
         assert(depth_multiplier_ == 1 || depth_multiplier_ >= out->extent(0));
-        call_depthwise_conv_uint8(input_buf, filter_buf, bias_buf, params,
-                                  stride_, dilation_, input_stride_x, output_range, output_buf);
+        call_depthwise_conv_uint8(input_buf, filter_buf, bias_buf, multiply_params_,
+                                  stride_, dilation_, input_stride_x, output_range_, output_buf);
     } else {
         HLOG(FATAL) << "Unsupported type " << out->type() << "\n";
     }
@@ -1193,7 +1411,7 @@ void L2NormalizationOp::execute() {
         }
 
         const int input_zero = in->quantization().uniform_zero();
-        assert(input_zero >= 0 && input_zero <= 255);
+        HANNK_ASSUME(input_zero >= 0 && input_zero <= 255);
 
         assert(out->quantization().uniform_scale() == 1.0f / 128.0f);
         assert(out->quantization().uniform_zero() == 128);
@@ -1227,6 +1445,23 @@ BoundsMap PadOp::map_bounds(int input_idx, int output_idx) const {
     }
 }
 
+namespace {
+
+// Fill a crop of the output with the pad value. Edge slabs are often only a
+// few hundred bytes, where the fixed cost of launching the fill_uint8
+// pipeline exceeds the write itself, so fill contiguous crops with a single
+// memset instead.
+void fill_pad_crop(uint8_t pad_value, HalideBuffer<void> crop) {
+    if (is_contiguous(crop.raw_buffer())) {
+        memset(crop.begin(), pad_value, crop.size_in_bytes());
+    } else {
+        pad_to_rank(4, crop);
+        fill_uint8(pad_value, crop);
+    }
+}
+
+}  // namespace
+
 void PadOp::execute() {
     const TensorPtr &in = input(0);
     const TensorPtr &padding = input(1);
@@ -1275,16 +1510,12 @@ void PadOp::execute() {
             int input_max = input_buf.dim(d).max();
             int output_max = output_buf.dim(d).max();
             if (output_min < input_min) {
-                auto before = output_buf.cropped(d, output_min, input_min - output_min);
-                pad_to_rank(4, before);
-                fill_uint8(pad_value, before);
+                fill_pad_crop(pad_value, output_buf.cropped(d, output_min, input_min - output_min));
             } else {
                 input_min = output_min;
             }
             if (output_max > input_max) {
-                auto after = output_buf.cropped(d, input_max + 1, output_max - input_max);
-                pad_to_rank(4, after);
-                fill_uint8(pad_value, after);
+                fill_pad_crop(pad_value, output_buf.cropped(d, input_max + 1, output_max - input_max));
             } else {
                 input_max = output_max;
             }
@@ -1377,21 +1608,23 @@ const char *ReductionOp::to_string(Operator op) {
 }
 
 bool ReductionOp::reducing(int d) const {
-    const TensorPtr &in = input(0);
-    const TensorPtr &indices = input(1);
-    const auto &indices_buf = indices->buffer<const int32_t>();
-    for (int i = 0; i < indices_buf.dim(0).extent(); i++) {
-        int index = indices_buf(i);
-        if (index < 0) {
-            index += in->rank();
-        }
-        index = in->rank() - 1 - index;
-        assert(index >= 0 && index < in->rank());
-        if (index == d) {
-            return true;
+    if (reducing_mask_ < 0) {
+        const TensorPtr &in = input(0);
+        const TensorPtr &indices = input(1);
+        const auto &indices_buf = indices->buffer<const int32_t>();
+        int mask = 0;
+        for (int i = 0; i < indices_buf.dim(0).extent(); i++) {
+            int index = indices_buf(i);
+            if (index < 0) {
+                index += in->rank();
+            }
+            index = in->rank() - 1 - index;
+            assert(index >= 0 && index < in->rank());
+            mask |= 1 << index;
         }
+        reducing_mask_ = mask;
     }
-    return false;
+    return (reducing_mask_ >> d) & 1;
 }
 
 BoundsMap ReductionOp::map_bounds(int input_idx, int output_idx) const {
@@ -1440,6 +1673,40 @@ void ReductionOp::execute() {
     }
 }
 
+namespace {
+
+// A memcpy for reshape copies that could not be aliased away. The destination
+// is pure data movement that won't be read again until the consumer runs, so
+// for copies well past the cache sizes, use non-temporal stores: they avoid
+// evicting the rest of the working set, and skip the read-for-ownership
+// traffic on the destination lines.
+constexpr size_t kStreamingCopyThreshold = 1024 * 1024;
+
+void streaming_memcpy(void *dst_v, const void *src_v, size_t size) {
+#ifdef __AVX2__
+    uint8_t *dst = (uint8_t *)dst_v;
+    const uint8_t *src = (const uint8_t *)src_v;
+    if (size >= kStreamingCopyThreshold && ((uintptr_t)dst & 31) == 0) {
+        const size_t vectors = size / 32;
+        for (size_t i = 0; i < vectors; i++) {
+            _mm256_stream_si256((__m256i *)dst + i, _mm256_loadu_si256((const __m256i *)src + i));
+        }
+        // Streaming stores are weakly ordered, so fence before anything
+        // else can read the destination.
+        _mm_sfence();
+        dst_v = dst + vectors * 32;
+        src_v = src + vectors * 32;
+        size -= vectors * 32;
+        if (size == 0) {
+            return;
+        }
+    }
+#endif
+    memcpy(dst_v, src_v, size);
+}
+
+}  // namespace
+
 // TODO: Maybe this is only a reshape in some dimensions, in which case we might be able to split it.
 BoundsMap ReshapeOp::map_bounds(int input_idx, int output_idx) const {
     assert(input_idx == 0);
@@ -1486,6 +1753,9 @@ SmallVector<int, max_rank> ReshapeOp::calc_new_shape() const {
 }
 
 void ReshapeOp::execute() {
+    if (is_no_op_) {
+        return;
+    }
     const TensorPtr &in = input();
     const TensorPtr &out = output();
 
@@ -1519,7 +1789,7 @@ void ReshapeOp::execute() {
         assert(input_buf.end() == output_buf.end());
     } else {
         size_t output_size = output_buf.number_of_elements() * out->type().bytes();
-        memcpy(output_buf.data(), input_buf.data(), output_size);
+        streaming_memcpy(output_buf.data(), input_buf.data(), output_size);
     }
 }
 
@@ -1553,6 +1823,28 @@ BoundsMap SoftmaxOp::map_bounds(int input_idx, int output_idx) const {
         .elementwise(1, 1);
 }
 
+bool SoftmaxOp::prepare() {
+    // The multipliers are pure functions of beta and the tensors'
+    // quantization, so compute them once here instead of on every execute().
+    // Only the uint8 path uses them; float tensors have no quantization to
+    // read, and execute() reports them as unsupported.
+    if (input()->type() == halide_type_of<uint8_t>() &&
+        output()->type() == halide_type_of<uint8_t>()) {
+        // It's a easier to compute 2^(x*(B*log2(e))) than e^(x*B).
+        const float beta2 = beta_ * kLog2E;
+        input_multiplier_ = IntFloat<int16_t>(beta2 * input()->quantization().uniform_scale());
+        input_multiplier_ *= power_of_two(-softmax_input_shift);
+        assert(input_multiplier_.exponent() <= 0);
+
+        output_multiplier_ = IntFloat<int16_t>(output()->quantization().uniform_scale());
+        // TODO: Debug why this extra factor of 2 is needed. There's something
+        // wrong with the fixed point tricks in the implementation.
+        output_multiplier_ *= power_of_two(1);
+        assert(output_multiplier_.exponent() <= 0);
+    }
+    return true;
+}
+
 void SoftmaxOp::execute() {
     const TensorPtr &in = input();
     const TensorPtr &out = output();
@@ -1578,23 +1870,17 @@ void SoftmaxOp::execute() {
         // We don't need the input zero point because this op exploits the
         // identity exp(x_i)/sum(exp(x_i)) == exp(x_i + C)/sum(exp(x_i + C))
         const int output_zero = out->quantization().uniform_zero();
-        assert(output_zero >= 0 && output_zero <= 255);
-
-        // It's a easier to compute 2^(x*(B*log2(e))) than e^(x*B).
-        const float beta2 = beta_ * std::log2(std::exp(1.0f));
-        IntFloat<int16_t> input_multiplier(beta2 * in->quantization().uniform_scale());
-        input_multiplier *= power_of_two(-softmax_input_shift);
-        assert(input_multiplier.exponent() <= 0);
-
-        IntFloat<int16_t> output_multiplier(out->quantization().uniform_scale());
-        // TODO: Debug why this extra factor of 2 is needed. There's something
-        // wrong with the fixed point tricks in the implementation.
-        output_multiplier *= power_of_two(1);
-        assert(output_multiplier.exponent() <= 0);
-
+        HANNK_ASSUME(output_zero >= 0 && output_zero <= 255);
+
+        // The multipliers and shifts are runtime parameters of the AOT
+        // pipeline. JIT-specializing a pipeline per parameter tuple would let
+        // LLVM fold them into immediates, but the interpreter deliberately
+        // doesn't link libHalide, and the input-side parameters are only used
+        // to build a 256-entry table per call anyway, so the variable shifts
+        // are off the per-element path.
         auto softmax_rank2 = [&](halide_buffer_t *in_buf, halide_buffer_t *out_buf) {
-            softmax_uint8(in_buf, input_multiplier.mantissa(), -input_multiplier.exponent(),
-                          output_zero, output_multiplier.mantissa(), -output_multiplier.exponent(), out_buf);
+            softmax_uint8(in_buf, input_multiplier_.mantissa(), -input_multiplier_.exponent(),
+                          output_zero, output_multiplier_.mantissa(), -output_multiplier_.exponent(), out_buf);
         };
         loop_nest<2>(softmax_rank2, in_buf, out_buf);
     } else {
@@ -1712,7 +1998,11 @@ void TileConvFilterOp::execute() {
     const TensorPtr &in = input();
     const TensorPtr &out = output();
 
-    if (in->type() == halide_type_of<uint8_t>()) {
+    // Dispatch on the type code like dequantize_scalar does; this compiles
+    // to a table rather than a chain of halide_type_t comparisons as more
+    // filter types get supported.
+    switch (in->type().element_of().as_u32()) {
+    case halide_type_of<uint8_t>().as_u32(): {
         auto input_buf = in->buffer();
         auto output_buf = out->buffer();
 
@@ -1725,7 +2015,9 @@ void TileConvFilterOp::execute() {
         }
 
         tile_conv_filter_uint8(input_buf, input_zero, output_zero, output_buf);
-    } else {
+        break;
+    }
+    default:
         HLOG(FATAL) << "Unsupported type " << in->type() << "\n";
     }
 }
@@ -1760,6 +2052,40 @@ void TransposeOp::execute() {
     out_buf.copy_from(in_buf);
 }
 
+namespace {
+
+// With the quantization parameters fixed per call, Logistic and Tanh are pure
+// functions of the input byte. Rather than evaluate the fixed point program
+// at every element, evaluate it once for each of the 256 possible input
+// values, and then map the tensor through the resulting table.
+void build_unary_lut(HalideBuffer<int16_t> program_buf, std::array<uint8_t, 256> &lut) {
+    std::array<uint8_t, 256> index;
+    for (int i = 0; i < 256; i++) {
+        index[i] = (uint8_t)i;
+    }
+    HalideBuffer<uint8_t> index_buf(index.data(), 256, 1);
+    HalideBuffer<uint8_t> lut_buf(lut.data(), 256, 1);
+    elementwise_5xuint8_1xuint8(index_buf, index_buf, index_buf, index_buf, index_buf,
+                                program_buf, lut_buf);
+}
+
+void apply_unary_lut(const std::array<uint8_t, 256> &lut,
+                     const HalideBuffer<const void> &in, const HalideBuffer<void> &out) {
+    auto lut_rank1 = [&lut](halide_buffer_t *in_buf, halide_buffer_t *out_buf) {
+        const uint8_t *in_ptr = in_buf->host;
+        uint8_t *out_ptr = out_buf->host;
+        const int in_stride = in_buf->dim[0].stride;
+        const int out_stride = out_buf->dim[0].stride;
+        const int extent = out_buf->dim[0].extent;
+        for (int x = 0; x < extent; x++) {
+            out_ptr[x * out_stride] = lut[in_ptr[x * in_stride]];
+        }
+    };
+    elementwise_loop_nest<1>(lut_rank1, in, out);
+}
+
+}  // namespace
+
 const char *UnaryOp::to_string(UnaryOp::Operator op) {
     switch (op) {
     case Logistic:
@@ -1782,6 +2108,48 @@ const char *UnaryOp::to_string(UnaryOp::Operator op) {
     }
 }
 
+bool UnaryOp::prepare() {
+    const TensorPtr &in = input();
+    const TensorPtr &out = output();
+
+    if (in->type() != halide_type_of<uint8_t>() ||
+        out->type() != halide_type_of<uint8_t>() ||
+        (op_ != Logistic && op_ != Tanh)) {
+        return true;
+    }
+
+    const int input_zero = in->quantization().uniform_zero();
+    HANNK_ASSUME(input_zero >= 0 && input_zero <= 255);
+    const float in_scale = in->quantization().uniform_scale();
+
+    const int left_shift = 6;
+
+    IntFloat<int16_t> in_multiplier(in_scale);
+    in_multiplier *= power_of_two(-left_shift);
+    assert(in_multiplier.exponent() <= 0);
+
+    // Build a program to implement the op, and bake it into a table.
+    std::array<int16_t, 64> program_buffer;
+    ElementwiseAssembler p(program_buffer);
+    auto input_zeroed = p.sub(p.input(0), input_zero);
+    auto input_scaled = p.mul_shift(input_zeroed, in_multiplier.mantissa(), 15 - left_shift);
+    ElementwiseAssembler::Slot result;
+    if (op_ == Logistic) {
+        assert(out->quantization().uniform_scale() == 1.0f / 256.0f);
+        assert(out->quantization().uniform_zero() == 0);
+        result = p.logistic(8, input_scaled, -in_multiplier.exponent());
+    } else {
+        assert(out->quantization().uniform_scale() == 1.0f / 128.0f);
+        assert(out->quantization().uniform_zero() == 128);
+        result = p.add(p.tanh(7, input_scaled, -in_multiplier.exponent()), 128);
+    }
+    auto program_buf = p.assemble({result});
+
+    build_unary_lut(program_buf, lut_);
+    use_lut_ = true;
+    return true;
+}
+
 void UnaryOp::execute() {
     const TensorPtr &in = input();
     const TensorPtr &out = output();
@@ -1790,52 +2158,9 @@ void UnaryOp::execute() {
         auto in_buf = in->buffer();
         auto out_buf = out->buffer();
 
-        const int input_zero = in->quantization().uniform_zero();
-        assert(input_zero >= 0 && input_zero <= 255);
-        const float in_scale = in->quantization().uniform_scale();
-
-        const int left_shift = 6;
-
-        std::array<int16_t, 64> program_buffer;
-        if (op_ == Logistic) {
-            IntFloat<int16_t> in_multiplier(in_scale);
-            in_multiplier *= power_of_two(-left_shift);
-            assert(in_multiplier.exponent() <= 0);
-
-            assert(out->quantization().uniform_scale() == 1.0f / 256.0f);
-            assert(out->quantization().uniform_zero() == 0);
-
-            // Build a program to implement the logistic op.
-            ElementwiseAssembler p(program_buffer);
-            auto input_zeroed = p.sub(p.input(0), input_zero);
-            auto input_scaled = p.mul_shift(input_zeroed, in_multiplier.mantissa(), 15 - left_shift);
-            auto result = p.logistic(8, input_scaled, -in_multiplier.exponent());
-            auto program_buf = p.assemble({result});
-
-            auto logistic_rank2 = [&](halide_buffer_t *in_buf, halide_buffer_t *out_buf) {
-                elementwise_5xuint8_1xuint8(in_buf, in_buf, in_buf, in_buf, in_buf, program_buf, out_buf);
-            };
-            elementwise_loop_nest<2>(logistic_rank2, in_buf, out_buf);
-            return;
-        } else if (op_ == Tanh) {
-            IntFloat<int16_t> in_multiplier(in_scale);
-            in_multiplier *= power_of_two(-left_shift);
-            assert(in_multiplier.exponent() <= 0);
-
-            assert(out->quantization().uniform_scale() == 1.0f / 128.0f);
-            assert(out->quantization().uniform_zero() == 128);
-
-            // Build a program to implement the tanh op.
-            ElementwiseAssembler p(program_buffer);
-            auto input_zeroed = p.sub(p.input(0), input_zero);
-            auto input_scaled = p.mul_shift(input_zeroed, in_multiplier.mantissa(), 15 - left_shift);
-            auto result = p.add(p.tanh(7, input_scaled, -in_multiplier.exponent()), 128);
-            auto program_buf = p.assemble({result});
-
-            auto tanh_rank2 = [&](halide_buffer_t *in_buf, halide_buffer_t *out_buf) {
-                elementwise_5xuint8_1xuint8(in_buf, in_buf, in_buf, in_buf, in_buf, program_buf, out_buf);
-            };
-            elementwise_loop_nest<2>(tanh_rank2, in_buf, out_buf);
+        if (op_ == Logistic || op_ == Tanh) {
+            assert(use_lut_);
+            apply_unary_lut(lut_, in_buf, out_buf);
             return;
         } else if (op_ == Negate) {
             add_uint8(in_buf, in->quantization(), -1, in_buf, in->quantization(), 0, out_buf, out->quantization());
@@ -1867,50 +2192,16 @@ void UpsampleChannelsOp::execute() {
     const TensorPtr &out = output();
 
     if (in->type() == halide_type_of<uint8_t>() && out->type() == halide_type_of<uint8_t>()) {
-        auto in_buf = in->buffer();
-        auto out_buf = out->buffer();
-        upsample_channels_uint8(in_buf, factor_, out_buf);
+        // We don't need to adjust the buffer views, so skip the
+        // Halide::Runtime::Buffer copies and hand the kernel the tensors'
+        // own halide_buffer_ts.
+        upsample_channels_uint8(in->raw_buffer(), factor_, out->raw_buffer());
         return;
     }
     HLOG(FATAL)
         << "Unsupported UpsampleChannels op for types " << in->type() << ", " << out->type();
 }
 
-#define ACCEPT_AND_MUTATE_IMPL(OP)                                  \
-    void OP::accept_impl(OpVisitor *v) const {                      \
-        v->visit(this);                                             \
-    }                                                               \
-    Op::OpMutatorFn OP::mutate_impl() const {                       \
-        return [](OpPtr op, OpMutator *m) -> OpPtr {                \
-            std::unique_ptr<OP> o(static_cast<OP *>(op.release())); \
-            return m->visit(std::move(o));                          \
-        };                                                          \
-    }
-
-ACCEPT_AND_MUTATE_IMPL(BinaryOp)
-ACCEPT_AND_MUTATE_IMPL(ConcatenationOp)
-ACCEPT_AND_MUTATE_IMPL(ConvOp)
-ACCEPT_AND_MUTATE_IMPL(DepthwiseConv2DOp)
-ACCEPT_AND_MUTATE_IMPL(ElementwiseProgramOp)
-ACCEPT_AND_MUTATE_IMPL(GatherOp)
-ACCEPT_AND_MUTATE_IMPL(L2NormalizationOp)
-ACCEPT_AND_MUTATE_IMPL(PadOp)
-ACCEPT_AND_MUTATE_IMPL(Pool2DOp)
-ACCEPT_AND_MUTATE_IMPL(ShapeOp)
-ACCEPT_AND_MUTATE_IMPL(SoftmaxOp)
-ACCEPT_AND_MUTATE_IMPL(SpaceDepthOp)
-ACCEPT_AND_MUTATE_IMPL(SplitOp)
-ACCEPT_AND_MUTATE_IMPL(ReductionOp)
-ACCEPT_AND_MUTATE_IMPL(ReshapeOp)
-ACCEPT_AND_MUTATE_IMPL(TileConvFilterOp)
-ACCEPT_AND_MUTATE_IMPL(TransposeOp)
-ACCEPT_AND_MUTATE_IMPL(UpsampleChannelsOp)
-ACCEPT_AND_MUTATE_IMPL(UnaryOp)
-
-ACCEPT_AND_MUTATE_IMPL(OpGroup)
-
-#undef ACCEPT_AND_MUTATE_IMPL
-
 void OpVisitor::visit(const OpGroup *op) {
     for (int i = 0; i < op->op_count(); i++) {
         op->op(i)->accept(this);
@@ -2,6 +2,7 @@
 #define HANNK_OPS_H_
 
 #include <array>
+#include <cmath>
 
 #include "interpreter/model.h"
 #include "util/small_vector.h"
@@ -22,6 +23,77 @@ enum class Padding {
     Valid,
 };
 
+// A type safe power of two.
+struct power_of_two {
+    int value;
+
+    explicit power_of_two(int value)
+        : value(value) {
+    }
+};
+
+// Represents a number as mantissa*2^exponent/2^(bits - 1), where bits = 8*sizeof(T)
+// This is very similar to a float.
+template<typename T>
+class IntFloat {
+    T mantissa_;
+    T exponent_;
+
+    static constexpr int log2_one = sizeof(T) * 8 - 1;
+    static constexpr int64_t one = 1LL << log2_one;
+
+public:
+    IntFloat()
+        : mantissa_(0), exponent_(0) {
+    }
+
+    IntFloat(float x) {
+        int exponent;
+        float mantissa_float = std::frexp(x, &exponent);
+        int64_t mantissa_long = (int64_t)std::round(mantissa_float * one);
+        assert(std::abs(mantissa_long) <= one);
+        if (mantissa_long == one) {
+            mantissa_long >>= 1;
+            ++exponent;
+        }
+        mantissa_ = mantissa_long;
+        exponent_ = exponent;
+    }
+
+    // Multiply this value by a constant power of 2.
+    IntFloat operator*=(power_of_two x) {
+        exponent_ += x.value;
+        return *this;
+    }
+
+    T mantissa() const {
+        if (exponent_ < -log2_one) {
+            return 0;
+        } else {
+            return mantissa_;
+        }
+    }
+
+    T exponent() const {
+        if (exponent_ < -log2_one) {
+            return -log2_one;
+        } else if (exponent_ > log2_one) {
+            return log2_one;
+        } else {
+            return exponent_;
+        }
+    }
+};
+
+// The quantization parameters of a multiply-accumulate op (conv and friends),
+// derived from the input, filter and output quantizations.
+struct MultiplyParams {
+    int a_zero;
+    int b_zero;
+    int c_zero;
+    IntFloat<int32_t> c;
+};
+
 // This is an abstract helper op for elementwise operations.
 class ElementwiseOp : public Op {
 public:
@@ -46,15 +118,36 @@ public:
 
     static const char *to_string(Operator op);
 
+    // Parameters for the quantized uint8 Add/Sub and Mul paths. They are pure
+    // functions of the tensors' QuantizationInfo, so we compute them once in
+    // prepare() instead of on every execute().
+    struct AddParams {
+        int in1_zero, in2_zero, out_zero;
+        int in1_multiplier, in2_multiplier;
+        Interval out_range;
+    };
+    struct MulParams {
+        int in1_zero, in2_zero, out_zero;
+        int32_t multiplier;
+        int shift;
+        Interval out_range;
+    };
+
 private:
     Operator op_;
     ActivationFunction activation_;
 
+    // calculated in prepare()
+    bool has_uint8_params_ = false;
+    AddParams add_params_;
+    MulParams mul_params_;
+
 public:
     BinaryOp(const TensorPtr &a, const TensorPtr &b, const TensorPtr &output, Operator op, ActivationFunction activation = ActivationFunction::None)
         : ElementwiseOp({a, b}, {output}), op_(op), activation_(activation) {
     }
 
+    bool prepare() override;
     void execute() override;
 
     std::string name() const override {
@@ -70,6 +163,10 @@ class ConcatenationOp : public Op {
     int axis_;
     bool is_no_op_ = false;
 
+    // filled in lazily by map_bounds(): the offset of each input along
+    // axis_, i.e. the partial sums of the preceding input extents.
+    mutable std::vector<int> input_axis_offsets_;
+
 public:
     ConcatenationOp(std::vector<TensorPtr> inputs, const TensorPtr &output, int axis)
         : Op(std::move(inputs), {output}), axis_(axis) {
@@ -104,6 +201,11 @@ class ConvOp : public Op {
     // calculated in prepare()
     int vector_reduction_ = 0;
     int vector_tile_ = 0;
+    MultiplyParams multiply_params_;
+    Interval output_range_;
+
+    // filled in lazily by filter_type()
+    mutable halide_type_t filter_type_ = halide_type_t(halide_type_int, 0, 0);
 
 public:
     ConvOp(const TensorPtr &input, const TensorPtr &filter, const TensorPtr &bias, const TensorPtr &output,
@@ -160,6 +262,8 @@ class DepthwiseConv2DOp : public Op {
 
     // calculated in prepare()
     int channel_alignment_ = 0;
+    MultiplyParams multiply_params_;
+    Interval output_range_;
 
 public:
     DepthwiseConv2DOp(const TensorPtr &input, const TensorPtr &filter, const TensorPtr &bias, const TensorPtr &output,
@@ -361,6 +465,9 @@ public:
 protected:
     const Operator op_;
 
+    // Bitmask of the dimensions being reduced, filled in lazily by reducing().
+    mutable int reducing_mask_ = -1;
+
     bool reducing(int d) const;
 
 public:
@@ -384,6 +491,8 @@ private:
 class ReshapeOp : public Op {
     SmallVector<int, max_rank> calc_new_shape() const;
 
+    bool is_no_op_ = false;
+
 public:
     ReshapeOp(const TensorPtr &input, const TensorPtr &shape_tensor, const TensorPtr &output)
         : Op({input, shape_tensor}, {output}) {
@@ -392,6 +501,10 @@ public:
         }
     }
 
+    void set_no_op() {
+        is_no_op_ = true;
+    }
+
     BoundsMap map_bounds(int input_idx, int output_idx) const override;
 
     void execute() override;
@@ -428,6 +541,10 @@ class SoftmaxOp : public Op {
     const float beta_;
     const int axis_;
 
+    // calculated in prepare()
+    IntFloat<int16_t> input_multiplier_;
+    IntFloat<int16_t> output_multiplier_;
+
 public:
     SoftmaxOp(const TensorPtr &input, const TensorPtr &output, float beta, int axis)
         : Op({input}, {output}), beta_(beta), axis_(axis) {
@@ -435,6 +552,7 @@ public:
 
     BoundsMap map_bounds(int input_idx, int output_idx) const override;
 
+    bool prepare() override;
     void execute() override;
 
     std::string name() const override {
@@ -551,11 +669,17 @@ public:
 private:
     Operator op_;
 
+    // calculated in prepare(): with the quantization fixed, Logistic and
+    // Tanh are pure functions of the input byte, baked into a table.
+    std::array<uint8_t, 256> lut_;
+    bool use_lut_ = false;
+
 public:
     UnaryOp(const TensorPtr &input, const TensorPtr &output, Operator op)
         : ElementwiseOp({input}, {output}), op_(op) {
     }
 
+    bool prepare() override;
     void execute() override;
 
     std::string name() const override {
@@ -698,6 +822,45 @@ protected:
     // clang-format on
 };
 
+// The accept_impl/mutate_impl redirects are defined here, after OpVisitor and
+// OpMutator are complete, rather than out-of-line in ops.cpp, so the
+// single-instruction bodies can be inlined at traversal call sites in other
+// translation units.
+#define ACCEPT_AND_MUTATE_IMPL(OP)                                  \
+    inline void OP::accept_impl(OpVisitor *v) const {               \
+        v->visit(this);                                             \
+    }                                                               \
+    inline Op::OpMutatorFn OP::mutate_impl() const {                \
+        return [](OpPtr op, OpMutator *m) -> OpPtr {                \
+            std::unique_ptr<OP> o(static_cast<OP *>(op.release())); \
+            return m->visit(std::move(o));                          \
+        };                                                          \
+    }
+
+ACCEPT_AND_MUTATE_IMPL(BinaryOp)
+ACCEPT_AND_MUTATE_IMPL(ConcatenationOp)
+ACCEPT_AND_MUTATE_IMPL(ConvOp)
+ACCEPT_AND_MUTATE_IMPL(DepthwiseConv2DOp)
+ACCEPT_AND_MUTATE_IMPL(ElementwiseProgramOp)
+ACCEPT_AND_MUTATE_IMPL(GatherOp)
+ACCEPT_AND_MUTATE_IMPL(L2NormalizationOp)
+ACCEPT_AND_MUTATE_IMPL(PadOp)
+ACCEPT_AND_MUTATE_IMPL(Pool2DOp)
+ACCEPT_AND_MUTATE_IMPL(ShapeOp)
+ACCEPT_AND_MUTATE_IMPL(SoftmaxOp)
+ACCEPT_AND_MUTATE_IMPL(SpaceDepthOp)
+ACCEPT_AND_MUTATE_IMPL(SplitOp)
+ACCEPT_AND_MUTATE_IMPL(ReductionOp)
+ACCEPT_AND_MUTATE_IMPL(ReshapeOp)
+ACCEPT_AND_MUTATE_IMPL(TileConvFilterOp)
+ACCEPT_AND_MUTATE_IMPL(TransposeOp)
+ACCEPT_AND_MUTATE_IMPL(UpsampleChannelsOp)
+ACCEPT_AND_MUTATE_IMPL(UnaryOp)
+
+ACCEPT_AND_MUTATE_IMPL(OpGroup)
+
+#undef ACCEPT_AND_MUTATE_IMPL
+
 }  // namespace hannk
 
 #endif  // HANNK_OPS_H_
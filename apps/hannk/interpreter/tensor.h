@@ -1,6 +1,7 @@
 #ifndef HANNK_TENSOR_H
 #define HANNK_TENSOR_H
 
+#include <cstring>
 #include <iostream>
 #include <list>
 #include <string>
@@ -12,6 +13,12 @@
 
 namespace hannk {
 
+// Most tensors are uniformly quantized (one scale/zero pair); only filters
+// use the per-channel form, where the vectors hold one entry per index along
+// 'dimension'. The uniform accessors below are the hot path: the ops read
+// them once per invocation and pass the scalars into the generated kernels,
+// which broadcast them across lanes, so per-element code never touches these
+// vectors.
 struct QuantizationInfo {
     std::vector<float> scale;
     std::vector<int32_t> zero;
@@ -21,6 +28,22 @@ struct QuantizationInfo {
         return dimension == r.dimension && scale == r.scale && zero == r.zero;
     }
 
+    static constexpr uint64_t kInvalidFingerprint = ~uint64_t(0);
+
+    // A cheap integer equality key: two fingerprints other than
+    // kInvalidFingerprint are equal iff they describe the same uniform
+    // quantization. Non-uniform infos always get kInvalidFingerprint, so
+    // callers comparing fingerprints must treat it as unequal to everything
+    // (including itself) or fall back to operator==.
+    uint64_t uniform_fingerprint() const {
+        if (scale.size() != 1 || zero.size() != 1) {
+            return kInvalidFingerprint;
+        }
+        uint32_t scale_bits;
+        memcpy(&scale_bits, &scale[0], sizeof(scale_bits));
+        return ((uint64_t)(uint32_t)zero[0] << 32) | scale_bits;
+    }
+
     float uniform_scale() const {
         assert(scale.size() == 1);
         return scale[0];
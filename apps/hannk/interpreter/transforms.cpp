@@ -143,10 +143,25 @@ class InPlaceReshape : public OpMutator {
         HCHECK(input->is_dense() == output->is_dense());
         HCHECK(input->number_of_elements() == output->number_of_elements());
 
+        bool aliased = false;
         if (input->can_alias(output, AliasType::Reshaped)) {
             Tensor::make_reshape_alias(input, output);
+            aliased = true;
         } else if (output->can_alias(input, AliasType::Reshaped)) {
             Tensor::make_reshape_alias(output, input);
+            aliased = true;
+        }
+
+        // Once the tensors share storage, the reshape has nothing left to do
+        // at execute time: writing the input writes the output. Dynamic
+        // outputs still need the op to resize them each inference. The op
+        // itself must stay in the graph even though it does nothing: it is
+        // what keeps the tensors it bridges alive for remove_dead_ops, the
+        // allocation planner, and the op-order checker, none of which look
+        // through shared storage. (Same situation as the no-op Concat/Split
+        // ops below.)
+        if (aliased && !output->is_dynamic()) {
+            op->set_no_op();
         }
 
         return op;
@@ -135,6 +135,32 @@ public:
 #define HCHECK(condition) \
     (condition) ? (void)0 : ::hannk::internal::Voidifier() & ::hannk::internal::Checker(#condition).ref()
 #endif
+
+/**
+ * HANNK_ASSUME() documents a value-range invariant, e.g. that a uint8
+ * quantization zero point is in [0, 255]. In debug builds it checks the
+ * condition like assert(); in release builds (where assert() would just
+ * vanish) it becomes an optimizer hint instead, letting the compiler
+ * narrow the arithmetic that follows. The condition must be free of
+ * side effects.
+ */
+#ifndef NDEBUG
+#define HANNK_ASSUME(condition) assert(condition)
+#elif defined(_MSC_VER) && !defined(__clang__)
+#define HANNK_ASSUME(condition) __assume(condition)
+#elif defined(__clang__)
+#define HANNK_ASSUME(condition) __builtin_assume(condition)
+#elif defined(__GNUC__)
+#define HANNK_ASSUME(condition)      \
+    do {                             \
+        if (!(condition)) {          \
+            __builtin_unreachable(); \
+        }                            \
+    } while (0)
+#else
+#define HANNK_ASSUME(condition) ((void)0)
+#endif
+
 }  // namespace hannk
 
 #endif  // HANNK_ERROR_UTIL_H
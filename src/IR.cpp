@@ -508,18 +508,26 @@ Stmt Block::make(Stmt first, Stmt rest) {
     internal_assert(first.defined()) << "Block of undefined\n";
     internal_assert(rest.defined()) << "Block of undefined\n";
 
-    Block *node = new Block;
-
-    if (const Block *b = first.as<Block>()) {
-        // Use a canonical block nesting order
-        node->first = b->first;
-        node->rest = Block::make(b->rest, std::move(rest));
-    } else {
-        node->first = std::move(first);
-        node->rest = std::move(rest);
+    // Use a canonical block nesting order: the 'first' field of a Block is
+    // never itself a Block. Rebalance iteratively; recursing here would use a
+    // stack frame per statement in the chain 'first'.
+    std::vector<Stmt> stmts;
+    while (const Block *b = first.as<Block>()) {
+        stmts.push_back(b->first);
+        first = b->rest;
+    }
+    stmts.push_back(std::move(first));
+
+    Stmt result = std::move(rest);
+    while (!stmts.empty()) {
+        Block *node = new Block;
+        node->first = std::move(stmts.back());
+        node->rest = std::move(result);
+        result = node;
+        stmts.pop_back();
     }
 
-    return node;
+    return result;
 }
 
 Stmt Block::make(const std::vector<Stmt> &stmts) {
@@ -282,13 +282,38 @@ Stmt IRMutator::visit(const Prefetch *op) {
 }
 
 Stmt IRMutator::visit(const Block *op) {
-    Stmt first = mutate(op->first);
-    Stmt rest = mutate(op->rest);
-    if (first.same_as(op->first) &&
-        rest.same_as(op->rest)) {
-        return op;
+    // Blocks are canonically right-nested chains, so mutate them iteratively
+    // rather than using a stack frame per statement in the chain.
+    std::vector<const Block *> blocks;
+    Stmt rest;
+    while (true) {
+        blocks.push_back(op);
+        rest = op->rest;
+        if (const Block *b = rest.as<Block>()) {
+            op = b;
+        } else {
+            break;
+        }
+    }
+
+    // Mutate the statements in program order.
+    bool changed = false;
+    std::vector<Stmt> firsts;
+    firsts.reserve(blocks.size());
+    for (const Block *b : blocks) {
+        firsts.push_back(mutate(b->first));
+        changed = changed || !firsts.back().same_as(b->first);
+    }
+    Stmt result = mutate(rest);
+    changed = changed || !result.same_as(rest);
+
+    if (!changed) {
+        return blocks.front();
+    }
+    for (size_t i = blocks.size(); i > 0; i--) {
+        result = Block::make(std::move(firsts[i - 1]), std::move(result));
     }
-    return Block::make(std::move(first), std::move(rest));
+    return result;
 }
 
 Stmt IRMutator::visit(const IfThenElse *op) {
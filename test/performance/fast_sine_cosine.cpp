@@ -21,6 +21,11 @@ int main(int argc, char **argv) {
     const float two_pi = 2.0f * static_cast<float>(M_PI);
     sin_f(x) = fast_sin(-two_pi * t + (1 - t) * two_pi);
     cos_f(x) = fast_cos(-two_pi * t + (1 - t) * two_pi);
+    // Note that sin/cos lower to scalar libm calls even inside a vectorized
+    // loop, so part of the measured gap is vector-vs-scalar rather than
+    // approximate-vs-accurate. We have no vector math library to bind the
+    // reference to, and scalar libm is what a user would otherwise get, so
+    // that is the comparison that matters here anyway.
     sin_ref(x) = sin(-two_pi * t + (1 - t) * two_pi);
     cos_ref(x) = cos(-two_pi * t + (1 - t) * two_pi);
     sin_f.vectorize(x, 8);
@@ -28,10 +33,18 @@ int main(int argc, char **argv) {
     sin_ref.vectorize(x, 8);
     cos_ref.vectorize(x, 8);
 
-    double t_fast_sin = 1e6 * benchmark([&]() { sin_f.realize({1000}); });
-    double t_fast_cos = 1e6 * benchmark([&]() { cos_f.realize({1000}); });
-    double t_sin = 1e6 * benchmark([&]() { sin_ref.realize({1000}); });
-    double t_cos = 1e6 * benchmark([&]() { cos_ref.realize({1000}); });
+    // Realize into preallocated buffers, and once before benchmarking, so
+    // neither allocation nor JIT compilation is part of any sample.
+    Buffer<float> sin_f_out(1000), cos_f_out(1000), sin_ref_out(1000), cos_ref_out(1000);
+    sin_f.realize(sin_f_out);
+    cos_f.realize(cos_f_out);
+    sin_ref.realize(sin_ref_out);
+    cos_ref.realize(cos_ref_out);
+
+    double t_fast_sin = 1e6 * benchmark([&]() { sin_f.realize(sin_f_out); });
+    double t_fast_cos = 1e6 * benchmark([&]() { cos_f.realize(cos_f_out); });
+    double t_sin = 1e6 * benchmark([&]() { sin_ref.realize(sin_ref_out); });
+    double t_cos = 1e6 * benchmark([&]() { cos_ref.realize(cos_ref_out); });
 
     printf("sin: %f ns per pixel\n"
            "fast_sine: %f ns per pixel\n"